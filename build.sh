@@ -3,6 +3,14 @@
 g++ -O2 -Iinclude -c main.cpp -o ./obj/main.o
 g++ -O2 -Iinclude -c ./src/gameoflife_t.cpp -o ./obj/gameoflife_t.o
 g++ -O2 -Iinclude -c ./src/player.cpp -o ./obj/player.o
+g++ -O2 -Iinclude -c ./src/genetic_algorithm.cpp -o ./obj/genetic_algorithm.o
+g++ -O2 -Iinclude -c ./src/sweep.cpp -o ./obj/sweep.o
+g++ -O2 -Iinclude -c ./src/enumerator.cpp -o ./obj/enumerator.o
+g++ -O2 -Iinclude -c ./src/remote_evaluation.cpp -o ./obj/remote_evaluation.o
+g++ -O2 -Iinclude -c worker.cpp -o ./obj/worker.o
+g++ -O2 -Iinclude -c ./tests/enumeration_check.cpp -o ./obj/enumeration_check.o
 
 
-g++ -o gameoflife_ga ./obj/main.o ./obj/gameoflife_t.o ./obj/player.o -lpthread -s
+g++ -o gameoflife_ga ./obj/main.o ./obj/gameoflife_t.o ./obj/player.o ./obj/genetic_algorithm.o ./obj/sweep.o ./obj/enumerator.o ./obj/remote_evaluation.o -lpthread -s
+g++ -o gameoflife_worker ./obj/worker.o ./obj/gameoflife_t.o ./obj/player.o ./obj/genetic_algorithm.o ./obj/remote_evaluation.o -lpthread -s
+g++ -o ./tests/enumeration_check ./obj/enumeration_check.o ./obj/gameoflife_t.o ./obj/player.o ./obj/genetic_algorithm.o ./obj/enumerator.o -lpthread -s
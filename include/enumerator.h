@@ -0,0 +1,35 @@
+#ifndef ENUMERATOR_H
+#define ENUMERATOR_H
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <genetic_algorithm.h>
+#include <ThreadPool.h>
+
+#define MAX_ENUMERATION_CELLS 36
+#define CHECKPOINT_INTERVAL_SECONDS 30
+
+using namespace std;
+
+//A scored starting board. The board is bit-packed: cell (x, y) of the starting board is bit y * startingboard_sizeX + x
+struct enumeration_entry_t
+{
+    double score;
+    size_t steps;
+    uint64_t pattern;
+};
+
+//Unpack a bit-packed starting board
+vector<vector<bool>> decode_pattern(uint64_t pattern, size_t sizeX, size_t sizeY);
+
+//Score every starting board of params.startingboard_sizeX * params.startingboard_sizeY cells exactly like the genetic algorithm does,
+//skipping the ones dying within prune_steps steps. Rotations, reflections and translations of a board are only skipped when they're
+//sure to get the same score, i.e. when neither of them ever touches the walls of the game board, or when the game board wraps.
+//Work is split in chunks of chunk_size patterns over the threads of pool. Progress is saved to checkpoint_path (if not empty)
+//and picked up from there if the file already exists. Returns the best top_k boards, best one first
+vector<enumeration_entry_t> enumerate_starting_boards(const ga_params_t& params, size_t top_k, size_t prune_steps, uint64_t chunk_size,
+                                                      ThreadPool& pool, size_t max_chunks_in_flight, const string& checkpoint_path, ostream& os = cout);
+
+#endif // ENUMERATOR_H
@@ -1,9 +1,15 @@
 #ifndef GAMEOFLIFE_T_H
 #define GAMEOFLIFE_T_H
 
+#include <cstdint>
 #include <iostream>
+#include <string>
 #include <vector>
 
+//Life-like rules are stored as a bitmask: bit n is set if a dead cell with n neighbours is born, bit 9 + n is set if a live cell with n neighbours survives
+#define RULE_SURVIVAL_SHIFT 9
+#define CONWAY_RULE ((1u << 3) | (1u << (RULE_SURVIVAL_SHIFT + 2)) | (1u << (RULE_SURVIVAL_SHIFT + 3)))
+
 using namespace std;
 
 class gameoflife_t
@@ -14,9 +20,13 @@ class gameoflife_t
         size_t sizeY;
         bool wrap_edges;
         size_t live_cells;
+        uint32_t rule;
 
     public:
-        gameoflife_t(size_t _sizeX = 100, size_t _sizeY = 100, bool _wrap_edges = false);
+        gameoflife_t(size_t _sizeX = 100, size_t _sizeY = 100, bool _wrap_edges = false, uint32_t _rule = CONWAY_RULE);
+        //
+        static uint32_t parse_rule(const string& rule_string);
+        static string rule_to_string(uint32_t rule_mask);
         //
         const decltype(board)& get_board() {return board;}
         size_t get_sizeX() {return sizeX;}
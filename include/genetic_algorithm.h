@@ -0,0 +1,70 @@
+#ifndef GENETIC_ALGORITHM_H
+#define GENETIC_ALGORITHM_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <functional>
+#include <player.h>
+#include <ThreadPool.h>
+
+using namespace std;
+
+//Every parameter that defines a single run of the genetic algorithm
+struct ga_params_t
+{
+    size_t population_size;
+    int gen_to_sim;
+    //Boards
+    size_t gameboard_sizeX;
+    size_t gameboard_sizeY;
+    size_t startingboard_sizeX;
+    size_t startingboard_sizeY;
+    bool wrap_edges;
+    float randomfill_percentage;
+    //Life-like rule, see gameoflife_t::parse_rule
+    uint32_t rule;
+    //Costs and rewards
+    double cost_per_starting_cell;
+    double reward_per_step_completed;
+    double reward_per_alive_cell_per_step;
+    //Seed of the random number generator of the run, the same seed and parameters always give the same run
+    unsigned int seed;
+    //Mutation probabilities, in percentage
+    float prob_cell_change_state;
+    float prob_cell_relocate;
+    float prob_big_mutations;
+    float prob_complete_mutation;
+};
+
+//Statistics of a single generation, one point of the convergence curve of a run
+struct ga_generation_stats_t
+{
+    int generation;
+    double all_players_avg_score;
+    double best_players_avg_score;
+    double best_score;
+};
+
+//Outcome of a whole run of the genetic algorithm
+struct ga_result_t
+{
+    vector<ga_generation_stats_t> curve;
+    double best_score;
+    vector<vector<bool>> best_starting_board;
+};
+
+//Function that simulates every player of the population and leaves the score in player::score
+using population_evaluator_t = function<void(vector<player>& population)>;
+
+//Simulate every player of the population on the threads of pool, blocking until all of them have been scored.
+//Multiple runs can share the same pool, their players are served in the order they've been enqueued
+void evaluate_population_on_pool(vector<player>& population, const ga_params_t& params, ThreadPool& pool);
+
+//Encode a starting board as a single string: rows separated by '/', dead cells as '.', live cells as 'o'
+string encode_starting_board(const vector<vector<bool>>& board);
+
+//Run the genetic algorithm described by params. If log is not null, the progress of every generation is printed to it
+ga_result_t run_genetic_algorithm(const ga_params_t& params, const population_evaluator_t& evaluate_population, ostream* log = nullptr);
+
+#endif // GENETIC_ALGORITHM_H
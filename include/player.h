@@ -3,12 +3,23 @@
 
 #include <vector>
 #include <array>
+#include <random>
 #include <gameoflife_t.h>
 
 #define MAX_HISTORY_SIZE 20
 
 using namespace std;
 
+//Smallest rectangle of the game board containing every cell that has been alive during a simulation
+struct live_extent_t
+{
+    bool any_alive;
+    size_t minX;
+    size_t minY;
+    size_t maxX;
+    size_t maxY;
+};
+
 class player
 {
     private:
@@ -30,13 +41,15 @@ class player
         gameoflife_t game;
         //Cumulative score achieved in the past simulations. Cleared when called the function init simulation
         double score;
+        //Steps completed in the past simulations. Cleared when called the function init simulation
+        size_t steps_completed;
 
         //---------------------------------------------------------------------------------------------------------------------------------------------------------
         //Constructor
-        player(size_t _game_board_sizeX = 100, size_t _game_board_sizeY = 100, size_t _starting_board_sizeX = 8, size_t _starting_board_sizeY = 8, bool _wrap_edges = false);
+        player(size_t _game_board_sizeX = 100, size_t _game_board_sizeY = 100, size_t _starting_board_sizeX = 8, size_t _starting_board_sizeY = 8, bool _wrap_edges = false, uint32_t _rule = CONWAY_RULE);
         //
         int set_starting_board_cell(size_t posX = 0, size_t posY = 0, bool state = 0);
-        void random_fill_starting_board(float percentage = 30.0f);
+        void random_fill_starting_board(mt19937& rng, float percentage = 30.0f);
         void clear_game_board() {game.clear_board();}
         void clear_starting_board() {starting_board = vector<vector<bool>>(starting_board_sizeY, vector<bool>(starting_board_sizeX, false));}
         const decltype(starting_board)& get_starting_board() {return starting_board;}
@@ -47,12 +60,13 @@ class player
         //
         int init_simulation(size_t offset_x, size_t offset_y, double _cost_per_starting_cell = 20, double _reward_per_step_completed = 1, double _reward_per_alive_cell_every_step = 0);
         int step_simulation(size_t num_steps = 1);
-        size_t step_simulation_until_periodic();
+        size_t step_simulation_until_periodic(live_extent_t* extent = nullptr);
         size_t step_simulation_until_wall_is_hit_or_periodic();
         int detect_periodicity(const vector<vector<vector<bool>>>& boards);
         //
-        int mutate(const decltype(starting_board)& ref_starting_board,  float probability_cell_change_state,    float probability_cell_relocate,
-                                                                        const float probability_big_mutations,  const float probability_complete_mutation, const float random_fill_percentage = 30);
+        //Every random choice is drawn from rng, so that players owned by different threads never share random state
+        int mutate(mt19937& rng, const decltype(starting_board)& ref_starting_board,    float probability_cell_change_state,    float probability_cell_relocate,
+                                                                                        const float probability_big_mutations,  const float probability_complete_mutation, const float random_fill_percentage = 30);
         //
         virtual ~player();
 };
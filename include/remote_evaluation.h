@@ -0,0 +1,68 @@
+#ifndef REMOTE_EVALUATION_H
+#define REMOTE_EVALUATION_H
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <genetic_algorithm.h>
+#include <player.h>
+
+//Protocol between master and workers, every integer is little endian and every double is sent as the little endian integer with its bits.
+//Request:  magic, batch id, number of boards (u32), game board size x, y, starting board size x, y (u32), wrap edges (u8),
+//          cost per starting cell, reward per step completed, reward per alive cell per step (f64), rule bitmask (u32),
+//          then every starting board bit-packed in (starting size x * starting size y + 7) / 8 bytes, cell (x, y) being bit y * size x + x.
+//Response: magic, batch id, number of boards (u32), then score (f64) and steps completed (u64) of every board, in the same order.
+//A worker answers the requests of a connection in the same order it received them, sending the result of every board as soon as it's ready.
+//The magic numbers change every time the layout of the messages does, so that masters and workers of different versions refuse each other
+#define REQUEST_MAGIC 0x3257474c        //"LGW2"
+#define RESPONSE_MAGIC 0x3252474c       //"LGR2"
+#define REQUEST_HEADER_SIZE 57
+#define RESPONSE_HEADER_SIZE 12
+#define MAX_BOARDS_PER_BATCH 1000000
+#define MAX_BOARD_SIZE 4096              //Largest side of a game board a worker accepts
+#define MAX_BOARD_CELLS (1 << 22)       //Largest number of cells of a game board a worker accepts, every board in flight keeps ~20 copies of it
+#define MAX_BATCH_BYTES (1 << 28)
+
+using namespace std;
+
+//Listen on the Unix domain socket socket_path and evaluate every batch received on num_threads threads, until the process is killed.
+//Throws if the socket can't be listened on or accept fails, after shutting down every connection
+int run_worker(const string& socket_path, size_t num_threads, ostream& os = cout);
+
+//Master side: evaluates populations by splitting them in batches of boards and streaming them to a set of worker processes
+class remote_evaluator_t
+{
+    private:
+        struct worker_t
+        {
+            string socket_path;
+            int fd;
+        };
+
+        vector<worker_t> workers;
+        size_t batch_size;
+        size_t max_batches_in_flight;
+        unsigned int timeout_seconds;
+        ostream* log;
+
+        bool connect_worker(worker_t& w);
+        void disconnect_worker(worker_t& w);
+
+    public:
+        //Every socket path is a worker, more than one batch is sent to each worker before waiting for the results of the first one.
+        //A worker that doesn't send any result for timeout_seconds is considered dead and its batches are handed to the other ones.
+        //Results are streamed board by board, so the timeout only needs to cover the simulation of a single board, not of a whole batch
+        remote_evaluator_t(const vector<string>& socket_paths, size_t _batch_size = 50, size_t _max_batches_in_flight = 2, unsigned int _timeout_seconds = 120, ostream* _log = &cerr);
+        //Not copyable, it owns the connections to the workers
+        remote_evaluator_t(const remote_evaluator_t&) = delete;
+        remote_evaluator_t& operator=(const remote_evaluator_t&) = delete;
+        //
+        //Set player::score and player::steps_completed of every player of the population. Workers that died are reconnected at every call.
+        //Throws if no worker is left to complete the evaluation
+        void evaluate(vector<player>& population, const ga_params_t& params);
+        //
+        virtual ~remote_evaluator_t();
+};
+
+#endif // REMOTE_EVALUATION_H
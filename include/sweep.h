@@ -0,0 +1,23 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <string>
+#include <vector>
+#include <genetic_algorithm.h>
+#include <ThreadPool.h>
+
+using namespace std;
+
+//Read a list of parameter sets from a sweep file. Every line is made of "key=value" tokens separated by spaces, keys that aren't specified
+//are taken from base_params. A value can be a comma separated list, in which case the line expands into every combination of its values.
+//Unless a seed is specified, configuration i gets base_params.seed + i.
+//Supported keys: cost_per_starting_cell, reward_per_step_completed, reward_per_alive_cell_per_step,
+//                prob_cell_change_state, prob_cell_relocate, prob_big_mutations, prob_complete_mutation, seed
+vector<ga_params_t> parse_sweep_file(const string& path, const ga_params_t& base_params);
+
+//Run every configuration, at most max_concurrent_runs at a time, all of them sharing the threads of pool.
+//Results are written to <output_prefix>_curves.csv (convergence curves) and <output_prefix>_best.csv (best boards) as soon as each configuration completes.
+//Configurations that fail are reported to os and left out of the results, returns how many of them failed
+int run_sweep(const vector<ga_params_t>& configs, ThreadPool& pool, size_t max_concurrent_runs, const string& output_prefix, ostream& os = cout);
+
+#endif // SWEEP_H
@@ -3,10 +3,17 @@
 #include <algorithm>
 #include <ctime>
 #include <thread>
+#include <string>
+#include <fstream>
+#include <stdexcept>
 
 #include <player.h>
 #include <gameoflife_t.h>
 #include <ThreadPool.h>
+#include <genetic_algorithm.h>
+#include <sweep.h>
+#include <enumerator.h>
+#include <remote_evaluation.h>
 
 #define POPULATION_SIZE 1000
 #define GEN_TO_SIM 500
@@ -19,6 +26,7 @@
 #define WRAP_EDGES false        //Setting it to true might make the function detect_periodicity fail, if gliders are spawned and don't crash into any structures
                                 //in the game board. This implies that the method step_simulation_until_periodic, will go on forever.
 #define RANDOMFILL_PERCENTAGE 30
+#define RULE "B3/S23"                   //Life-like rule in B/S notation, can be overridden at runtime with --rule
 
 #define COST_PER_STARTING_CELL 3
 #define REWARD_PER_STEP_COMPLETED 1
@@ -29,80 +37,158 @@
 #define PROB_BIG_MUTATIONS 7.0
 #define PROB_COMPLETE_MUTATION 7.0
 
-using namespace std;
+#define SWEEP_MAX_CONCURRENT_RUNS 8     //Maximum number of configurations of a sweep that are kept in memory and run at the same time
 
-int main() {
-    srand(static_cast<unsigned>(time(0)));
-    const unsigned int available_threads = (thread::hardware_concurrency() == 0 ? FALLBACK_NUM_THREADS : thread::hardware_concurrency());
+#define ENUM_TOP_K 10                   //Number of best starting boards reported by the enumeration
+#define ENUM_PRUNE_STEPS 2              //Starting boards that die within this many steps are not scored by the enumeration
+#define ENUM_CHUNK_SIZE 65536           //Number of patterns enumerated by every task of the thread pool
 
-    vector<player> population(POPULATION_SIZE, player(GAMEBOARD_SIZEX, GAMEBOARD_SIZEY, STARTINGBOARD_SIZEX, STARTINGBOARD_SIZEY, WRAP_EDGES));
-    ThreadPool simplayer_pool(available_threads);
+#define WORKER_BATCH_SIZE 50            //Number of starting boards sent to a worker process in a single batch
+#define WORKER_BATCHES_IN_FLIGHT 2      //Number of batches sent to a worker process before waiting for the results of the first one
+#define WORKER_TIMEOUT_SECONDS 120      //A worker process that doesn't send back any result within this time is considered dead
 
-    //Skip the worst 90% of the players
-    size_t worst_best_player_index = (9 * population.size()) / 10;
+using namespace std;
 
-    double best_players_curr_gen_avg_score = 0;
-    double best_players_prev_gen_avg_score = 0;
-    double all_players_curr_gen_avg_score = 0;
-    double all_players_prev_gen_avg_score = 0;
+static void print_usage(ostream& os, const string& program){
+    os << "Usage: " << program << " [--rule <B/S rule>]" << endl
+       << "       " << program << " [--rule <B/S rule>] --sweep <sweep file> [output prefix]" << endl
+       << "       " << program << " [--rule <B/S rule>] --enumerate <starting board size x> <starting board size y> [top K] [output prefix]" << endl
+       << "       " << program << " [--rule <B/S rule>] --workers <socket path>[,<socket path>...]" << endl;
+}
 
-    for(player &p : population)
-        p.random_fill_starting_board(RANDOMFILL_PERCENTAGE);
+int main(int argc, char* argv[]) {
+    const unsigned int available_threads = (thread::hardware_concurrency() == 0 ? FALLBACK_NUM_THREADS : thread::hardware_concurrency());
 
-    for(int generation = 0; generation < GEN_TO_SIM; ++generation) {
-        cout << "------------------------------------------------------------------------------------------------" << endl;
-        cout << "Simulationg now generation " << generation << "/" << GEN_TO_SIM << endl;
-        best_players_curr_gen_avg_score = 0;
-        all_players_curr_gen_avg_score = 0;
+    ga_params_t params;
+    params.population_size = POPULATION_SIZE;
+    params.gen_to_sim = GEN_TO_SIM;
+    params.gameboard_sizeX = GAMEBOARD_SIZEX;
+    params.gameboard_sizeY = GAMEBOARD_SIZEY;
+    params.startingboard_sizeX = STARTINGBOARD_SIZEX;
+    params.startingboard_sizeY = STARTINGBOARD_SIZEY;
+    params.wrap_edges = WRAP_EDGES;
+    params.randomfill_percentage = RANDOMFILL_PERCENTAGE;
+    params.seed = static_cast<unsigned>(time(0));
+    params.rule = gameoflife_t::parse_rule(RULE);
+    params.cost_per_starting_cell = COST_PER_STARTING_CELL;
+    params.reward_per_step_completed = REWARD_PER_STEP_COMPLETED;
+    params.reward_per_alive_cell_per_step = REWARD_PER_ALIVE_CELL_PER_STEP;
+    params.prob_cell_change_state = PROB_CELL_CHANGE_STATE;
+    params.prob_cell_relocate = PROB_CELL_RELOCATE;
+    params.prob_big_mutations = PROB_BIG_MUTATIONS;
+    params.prob_complete_mutation = PROB_COMPLETE_MUTATION;
+
+    //Options common to every mode can be anywhere in the command line, they're taken out of args so that only the mode and its arguments are left
+    //  --rule <B/S rule>
+    vector<string> args(argv + 1, argv + argc);
+    for(size_t i = 0; i < args.size(); ){
+        if(args[i] != "--rule"){
+            ++i;
+            continue;
+        }
+        if(i + 1 >= args.size()){
+            cerr << "--rule requires a rule, e.g. --rule B3/S23" << endl;
+            return 1;
+        }
+        try{
+            params.rule = gameoflife_t::parse_rule(args[i + 1]);
+        } catch(const exception& e){
+            cerr << e.what() << endl;
+            return 1;
+        }
+        args.erase(args.begin() + i, args.begin() + i + 2);
+    }
 
-        {
-            vector<future<size_t>> dummy_stepscompleted;
-            for(player& p : population){
-                dummy_stepscompleted.emplace_back(
-                    simplayer_pool.enqueue([&](){
-                        p.init_simulation((GAMEBOARD_SIZEX - STARTINGBOARD_SIZEX) / 2, (GAMEBOARD_SIZEY - STARTINGBOARD_SIZEY) / 2, COST_PER_STARTING_CELL, REWARD_PER_STEP_COMPLETED, REWARD_PER_ALIVE_CELL_PER_STEP);
-                        return p.step_simulation_until_periodic();
-                    })
-                );
-            }
+    //Whatever is left must be exactly one of the modes below with the right number of arguments, or nothing at all for the default run
+    const bool valid_args = args.empty() ||
+                            (args[0] == "--sweep" && args.size() >= 2 && args.size() <= 3) ||
+                            (args[0] == "--enumerate" && args.size() >= 3 && args.size() <= 5) ||
+                            (args[0] == "--workers" && args.size() == 2);
+    if(!valid_args){
+        print_usage(cerr, argv[0]);
+        return 1;
+    }
 
-            //Block current thread until all players have been simulated
-            for(auto&& dummy : dummy_stepscompleted) dummy.get();
-        }
+    ThreadPool simplayer_pool(available_threads);
 
-        for(player& p : population) {
-            //p.init_simulation((GAMEBOARD_SIZEX - STARTINGBOARD_SIZEX) / 2, (GAMEBOARD_SIZEY - STARTINGBOARD_SIZEY) / 2, COST_PER_STARTING_CELL, REWARD_PER_STEP_COMPLETED, REWARD_PER_ALIVE_CELL_PER_STEP);
-            //p.step_simulation_until_periodic();
-            all_players_curr_gen_avg_score += p.score;
+    //Parameter sweep: ./gameoflife_ga --sweep <sweep file> [output prefix]
+    if(!args.empty() && args[0] == "--sweep"){
+        const string output_prefix = (args.size() >= 3 ? args[2] : "sweep");
+        int failed_configs = 0;
+        try{
+            const auto configs = parse_sweep_file(args[1], params);
+            cout << "Running " << configs.size() << " configurations on " << available_threads << " threads" << endl;
+            failed_configs = run_sweep(configs, simplayer_pool, SWEEP_MAX_CONCURRENT_RUNS, output_prefix);
+        } catch(const exception& e){
+            cerr << "Sweep failed: " << e.what() << endl;
+            return 1;
         }
-        all_players_curr_gen_avg_score /= (double)POPULATION_SIZE;
+        cout << "Results written to " << output_prefix << "_curves.csv and " << output_prefix << "_best.csv" << endl;
+        return (failed_configs == 0 ? 0 : 1);
+    }
 
-        sort(population.begin(), population.end(), [](const player & p1, const player & p2) {return p1.score < p2.score;});
+    //Exhaustive enumeration: ./gameoflife_ga --enumerate <starting board size x> <starting board size y> [top K] [output prefix]
+    if(!args.empty() && args[0] == "--enumerate"){
+        const string output_prefix = (args.size() >= 5 ? args[4] : "enumeration");
+        try{
+            params.startingboard_sizeX = stoul(args[1]);
+            params.startingboard_sizeY = stoul(args[2]);
+            const size_t top_k = (args.size() >= 4 ? stoul(args[3]) : ENUM_TOP_K);
+
+            const auto top = enumerate_starting_boards(params, top_k, ENUM_PRUNE_STEPS, ENUM_CHUNK_SIZE, simplayer_pool, 4 * available_threads, output_prefix + "_checkpoint.txt");
+
+            ofstream top_file(output_prefix + "_top.csv");
+            if(!top_file)
+                throw runtime_error("can't open " + output_prefix + "_top.csv for writing");
+            top_file << "rank,score,steps,pattern,rule,starting_board" << endl;
+
+            player p(params.gameboard_sizeX, params.gameboard_sizeY, params.startingboard_sizeX, params.startingboard_sizeY, params.wrap_edges, params.rule);
+            for(size_t i = 0; i < top.size(); ++i){
+                const auto board = decode_pattern(top[i].pattern, params.startingboard_sizeX, params.startingboard_sizeY);
+                top_file << i << "," << top[i].score << "," << top[i].steps << "," << top[i].pattern << "," << gameoflife_t::rule_to_string(params.rule) << "," << encode_starting_board(board) << endl;
+
+                for(size_t y = 0; y < params.startingboard_sizeY; ++y)
+                    for(size_t x = 0; x < params.startingboard_sizeX; ++x)
+                        p.set_starting_board_cell(x, y, board[y][x]);
+                cout << "(" << i << ") Score of the following board: " << top[i].score << " (" << top[i].steps << " steps)" << endl;
+                p.print_starting_board();
+            }
+        } catch(const exception& e){
+            cerr << "Enumeration failed: " << e.what() << endl;
+            return 1;
+        }
+        cout << "Results written to " << output_prefix << "_top.csv" << endl;
+        return 0;
+    }
 
-        for(auto i = worst_best_player_index; i < population.size(); ++i) {
-            auto& p = population[i];
-            cout << "(" << i << ") Score of the following board: " << p.score << endl;
-            p.print_starting_board();
-            best_players_curr_gen_avg_score += p.score;
+    //Evaluation on worker processes: ./gameoflife_ga --workers <socket path>[,<socket path>...]
+    if(!args.empty() && args[0] == "--workers"){
+        vector<string> socket_paths;
+        {
+            string socket_list = args[1];
+            size_t begin = 0;
+            for(size_t comma = socket_list.find(','); begin <= socket_list.size(); comma = socket_list.find(',', begin)){
+                if(comma == string::npos) comma = socket_list.size();
+                if(comma > begin) socket_paths.push_back(socket_list.substr(begin, comma - begin));
+                begin = comma + 1;
+            }
         }
-        best_players_curr_gen_avg_score /= (double)(population.size() - worst_best_player_index);
-        //
-        cout << "Current generation average  score: " << all_players_curr_gen_avg_score  << " (prev.: " << all_players_prev_gen_avg_score  << ")" << endl;
-        cout << "Current generation best avg score: " << best_players_curr_gen_avg_score << " (prev.: " << best_players_prev_gen_avg_score << ")" << endl;
-        //
-        //
-        for(size_t i = 0; i < worst_best_player_index; ++i) {
-            auto& p = population[i];
-            //This formula picks the best player in a round robin way with each cycle of this for loop (offset + (i % num_best_players))
-            auto& ref_p = population[worst_best_player_index + (i % (population.size() - worst_best_player_index))];
-
-            p.mutate(ref_p.get_starting_board(), PROB_CELL_CHANGE_STATE, PROB_CELL_RELOCATE, PROB_BIG_MUTATIONS, PROB_COMPLETE_MUTATION, RANDOMFILL_PERCENTAGE);
+
+        try{
+            remote_evaluator_t remote_evaluator(socket_paths, WORKER_BATCH_SIZE, WORKER_BATCHES_IN_FLIGHT, WORKER_TIMEOUT_SECONDS);
+            run_genetic_algorithm(params, [&](vector<player>& population){
+                remote_evaluator.evaluate(population, params);
+            }, &cout);
+        } catch(const exception& e){
+            cerr << "Simulation failed: " << e.what() << endl;
+            return 1;
         }
-        //
-        //
-        all_players_prev_gen_avg_score = all_players_curr_gen_avg_score;
-        best_players_prev_gen_avg_score = best_players_curr_gen_avg_score;
+        return 0;
     }
 
+    run_genetic_algorithm(params, [&](vector<player>& population){
+        evaluate_population_on_pool(population, params, simplayer_pool);
+    }, &cout);
+
     return 0;
 }
@@ -0,0 +1,375 @@
+#include "enumerator.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <algorithm>
+#include <vector>
+#include <deque>
+#include <string>
+#include <chrono>
+#include <cstdio>
+
+using namespace std;
+
+//Result of the enumeration of a contiguous range of patterns
+struct enumeration_chunk_t
+{
+    vector<enumeration_entry_t> top;
+    uint64_t scored;
+    uint64_t end;
+};
+
+vector<vector<bool>> decode_pattern(uint64_t pattern, size_t sizeX, size_t sizeY){
+    vector<vector<bool>> board(sizeY, vector<bool>(sizeX, false));
+    for(size_t i = 0; i < sizeY; ++i)
+        for(size_t j = 0; j < sizeX; ++j)
+            board[i][j] = (pattern >> (i * sizeX + j)) & 1;
+    return board;
+}
+
+//Ordering of the entries: higher score first, ties broken by the pattern so that results don't depend on the order chunks complete in
+static bool is_better(const enumeration_entry_t& e1, const enumeration_entry_t& e2){
+    if(e1.score != e2.score)
+        return e1.score > e2.score;
+    return e1.pattern < e2.pattern;
+}
+
+//Keep the best top_k entries in a heap whose front is the worst of them
+static void push_top_k(vector<enumeration_entry_t>& top, size_t top_k, const enumeration_entry_t& entry){
+    if(top.size() < top_k){
+        top.push_back(entry);
+        push_heap(top.begin(), top.end(), is_better);
+    } else if(top_k > 0 && is_better(entry, top.front())){
+        pop_heap(top.begin(), top.end(), is_better);
+        top.back() = entry;
+        push_heap(top.begin(), top.end(), is_better);
+    }
+}
+
+//Image of a pattern under an element of D4 followed by a translation inside the starting board
+struct orbit_image_t
+{
+    uint64_t pattern;
+    //Element of D4: bit 2 swaps the axes, bit 0 mirrors x, bit 1 mirrors y
+    int transform;
+    //Subtracted from the transformed coordinates to move the image to the top left corner of the starting board
+    int normalizeX;
+    int normalizeY;
+    //Added afterwards to move it inside the starting board
+    int shiftX;
+    int shiftY;
+};
+
+static void apply_transform(int transform, int& x, int& y){
+    if(transform & 4) swap(x, y);
+    if(transform & 1) x = -x;
+    if(transform & 2) y = -y;
+}
+
+//Every rotation, reflection and translation of pattern that fits in the starting board, pattern itself included
+static vector<orbit_image_t> orbit_images(uint64_t pattern, size_t sizeX, size_t sizeY){
+    //Coordinates of the live cells
+    int cellsX[MAX_ENUMERATION_CELLS];
+    int cellsY[MAX_ENUMERATION_CELLS];
+    size_t num_cells = 0;
+    for(size_t i = 0; i < sizeY; ++i){
+        for(size_t j = 0; j < sizeX; ++j){
+            if((pattern >> (i * sizeX + j)) & 1){
+                cellsX[num_cells] = j;
+                cellsY[num_cells] = i;
+                ++num_cells;
+            }
+        }
+    }
+
+    vector<orbit_image_t> images;
+    int transformedX[MAX_ENUMERATION_CELLS];
+    int transformedY[MAX_ENUMERATION_CELLS];
+    for(int t = 0; t < 8; ++t){
+        int minX = MAX_ENUMERATION_CELLS, minY = MAX_ENUMERATION_CELLS, maxX = -MAX_ENUMERATION_CELLS, maxY = -MAX_ENUMERATION_CELLS;
+        for(size_t c = 0; c < num_cells; ++c){
+            transformedX[c] = cellsX[c];
+            transformedY[c] = cellsY[c];
+            apply_transform(t, transformedX[c], transformedY[c]);
+            minX = min(minX, transformedX[c]); maxX = max(maxX, transformedX[c]);
+            minY = min(minY, transformedY[c]); maxY = max(maxY, transformedY[c]);
+        }
+
+        //Every position of the transformed pattern that fits in the starting board
+        for(int shiftY = 0; maxY - minY + shiftY < static_cast<int>(sizeY); ++shiftY){
+            for(int shiftX = 0; maxX - minX + shiftX < static_cast<int>(sizeX); ++shiftX){
+                uint64_t image_pattern = 0;
+                for(size_t c = 0; c < num_cells; ++c)
+                    image_pattern |= 1ULL << ((transformedY[c] - minY + shiftY) * sizeX + (transformedX[c] - minX + shiftX));
+                images.push_back({image_pattern, t, minX, minY, shiftX, shiftY});
+            }
+        }
+    }
+
+    return images;
+}
+
+//A pattern is canonical if it's the smallest of its orbit, which implies touching the top and left borders of the starting board
+static bool is_canonical(uint64_t pattern, size_t sizeX, size_t sizeY){
+    if(pattern == 0)
+        return false;
+
+    //Cheap check first: the smallest translation always touches the top row and the left column
+    const uint64_t top_row_mask = (1ULL << sizeX) - 1;
+    uint64_t left_column_mask = 0;
+    for(size_t i = 0; i < sizeY; ++i)
+        left_column_mask |= 1ULL << (i * sizeX);
+
+    if(!(pattern & top_row_mask) || !(pattern & left_column_mask))
+        return false;
+
+    for(const auto& image : orbit_images(pattern, sizeX, sizeY))
+        if(image.pattern < pattern)
+            return false;
+
+    return true;
+}
+
+//An image is scored exactly like the canonical pattern if the board wraps (and the transform doesn't swap the axes of a non square board),
+//or if the evolution of the canonical pattern never touched a border and the same evolution, moved like the image, doesn't either.
+//In both cases the image evolves exactly like the canonical pattern, just moved, so its score and steps are the same
+static bool image_scores_like_canonical(const orbit_image_t& image, const live_extent_t& extent, size_t offsetX, size_t offsetY, const ga_params_t& params){
+    if(params.wrap_edges)
+        return !(image.transform & 4) || params.gameboard_sizeX == params.gameboard_sizeY;
+
+    const int max_cellX = params.gameboard_sizeX - 2;
+    const int max_cellY = params.gameboard_sizeY - 2;
+    if(!extent.any_alive)
+        return true;
+    if(extent.minX < 1 || extent.minY < 1 || static_cast<int>(extent.maxX) > max_cellX || static_cast<int>(extent.maxY) > max_cellY)
+        return false;
+
+    //Extent relative to the starting board, moved like the image
+    int x1 = extent.minX - offsetX, y1 = extent.minY - offsetY;
+    int x2 = extent.maxX - offsetX, y2 = extent.maxY - offsetY;
+    apply_transform(image.transform, x1, y1);
+    apply_transform(image.transform, x2, y2);
+
+    const int minX = min(x1, x2) - image.normalizeX + image.shiftX + offsetX;
+    const int maxX = max(x1, x2) - image.normalizeX + image.shiftX + offsetX;
+    const int minY = min(y1, y2) - image.normalizeY + image.shiftY + offsetY;
+    const int maxY = max(y1, y2) - image.normalizeY + image.shiftY + offsetY;
+
+    return minX >= 1 && minY >= 1 && maxX <= max_cellX && maxY <= max_cellY;
+}
+
+//Check if a pattern dies within num_steps steps under rule, with a cheap simulation on bit-packed rows big enough to never touch a border
+static bool dies_within(uint64_t pattern, size_t sizeX, size_t sizeY, size_t num_steps, uint32_t rule){
+    if(num_steps == 0)
+        return false;
+
+    const size_t rows_count = sizeY + 2 * num_steps + 2;
+    const size_t columns_count = sizeX + 2 * num_steps + 2;
+    vector<uint64_t> rows(rows_count, 0);
+    vector<uint64_t> new_rows(rows_count, 0);
+
+    for(size_t i = 0; i < sizeY; ++i)
+        rows[i + num_steps + 1] = ((pattern >> (i * sizeX)) & ((1ULL << sizeX) - 1)) << (num_steps + 1);
+
+    for(size_t s = 0; s < num_steps; ++s){
+        bool any_alive = false;
+        for(size_t i = 1; i < rows_count - 1; ++i){
+            new_rows[i] = 0;
+            for(size_t j = 1; j < columns_count - 1; ++j){
+                int num_neighbours = 0;
+                for(size_t di = i - 1; di <= i + 1; ++di)
+                    num_neighbours += ((rows[di] >> (j - 1)) & 1) + ((rows[di] >> j) & 1) + ((rows[di] >> (j + 1)) & 1);
+                bool alive = (rows[i] >> j) & 1;
+                num_neighbours -= alive;
+
+                new_rows[i] |= static_cast<uint64_t>((rule >> (alive * RULE_SURVIVAL_SHIFT + num_neighbours)) & 1) << j;
+            }
+            any_alive |= (new_rows[i] != 0);
+        }
+        if(!any_alive)
+            return true;
+        rows.swap(new_rows);
+    }
+
+    return false;
+}
+
+//Score every canonical and surviving pattern in [begin, end). The other patterns of its orbit are scored too, unless it's sure their score is the same
+static enumeration_chunk_t enumerate_chunk(const ga_params_t& params, uint64_t begin, uint64_t end, size_t top_k, size_t prune_steps){
+    player p(params.gameboard_sizeX, params.gameboard_sizeY, params.startingboard_sizeX, params.startingboard_sizeY, params.wrap_edges, params.rule);
+    const size_t offsetX = (params.gameboard_sizeX - params.startingboard_sizeX) / 2;
+    const size_t offsetY = (params.gameboard_sizeY - params.startingboard_sizeY) / 2;
+    enumeration_chunk_t chunk;
+    chunk.scored = 0;
+    chunk.end = end;
+
+    //Same scoring as the genetic algorithm
+    auto score_pattern = [&](uint64_t pattern, live_extent_t* extent){
+        for(size_t i = 0; i < params.startingboard_sizeY; ++i)
+            for(size_t j = 0; j < params.startingboard_sizeX; ++j)
+                p.set_starting_board_cell(j, i, (pattern >> (i * params.startingboard_sizeX + j)) & 1);
+
+        p.init_simulation(offsetX, offsetY, params.cost_per_starting_cell, params.reward_per_step_completed, params.reward_per_alive_cell_per_step);
+        size_t steps = p.step_simulation_until_periodic(extent);
+
+        push_top_k(chunk.top, top_k, {p.score, steps, pattern});
+        ++chunk.scored;
+    };
+
+    for(uint64_t pattern = begin; pattern < end; ++pattern){
+        if(!is_canonical(pattern, params.startingboard_sizeX, params.startingboard_sizeY))
+            continue;
+        //The whole orbit dies with the canonical pattern, since pruning never lets the cells reach the walls
+        if(dies_within(pattern, params.startingboard_sizeX, params.startingboard_sizeY, prune_steps, params.rule))
+            continue;
+
+        live_extent_t extent;
+        score_pattern(pattern, &extent);
+
+        //Every other distinct pattern of the orbit that can't be proven to score like the canonical one gets its own simulation
+        auto images = orbit_images(pattern, params.startingboard_sizeX, params.startingboard_sizeY);
+        vector<pair<uint64_t, bool>> distinct_images;
+        for(const auto& image : images)
+            if(image.pattern != pattern)
+                distinct_images.push_back({image.pattern, image_scores_like_canonical(image, extent, offsetX, offsetY, params)});
+        sort(distinct_images.begin(), distinct_images.end());
+
+        for(size_t i = 0; i < distinct_images.size(); ){
+            uint64_t image_pattern = distinct_images[i].first;
+            bool scores_like_canonical = false;
+            for(; i < distinct_images.size() && distinct_images[i].first == image_pattern; ++i)
+                scores_like_canonical |= distinct_images[i].second;
+
+            if(!scores_like_canonical)
+                score_pattern(image_pattern, nullptr);
+        }
+    }
+
+    return chunk;
+}
+
+//First line of a checkpoint, used to refuse resuming an enumeration made with different parameters
+static string checkpoint_header(const ga_params_t& params, size_t top_k, size_t prune_steps){
+    ostringstream header;
+    header << setprecision(17) << "enumeration-v2"
+           << " " << params.startingboard_sizeX << " " << params.startingboard_sizeY << " " << top_k << " " << prune_steps
+           << " " << params.gameboard_sizeX << " " << params.gameboard_sizeY << " " << params.wrap_edges << " " << params.rule
+           << " " << params.cost_per_starting_cell << " " << params.reward_per_step_completed << " " << params.reward_per_alive_cell_per_step;
+    return header.str();
+}
+
+//Write the checkpoint to a temporary file first and then rename it, so that an interrupted write never destroys the previous checkpoint
+static void save_checkpoint(const string& path, const string& header, uint64_t next_pattern, uint64_t scored, const vector<enumeration_entry_t>& top){
+    const string tmp_path = path + ".tmp";
+    {
+        ofstream file(tmp_path);
+        if(!file)
+            throw runtime_error("can't open checkpoint " + tmp_path + " for writing");
+
+        file << header << endl;
+        file << next_pattern << " " << scored << endl;
+        file << setprecision(17);
+        for(const auto& entry : top)
+            file << entry.score << " " << entry.steps << " " << entry.pattern << endl;
+
+        if(!file)
+            throw runtime_error("failed writing checkpoint " + tmp_path);
+    }
+
+    if(rename(tmp_path.c_str(), path.c_str()) != 0)
+        throw runtime_error("can't replace checkpoint " + path);
+}
+
+//Returns false if there's no checkpoint to resume from
+static bool load_checkpoint(const string& path, const string& header, uint64_t& next_pattern, uint64_t& scored, vector<enumeration_entry_t>& top, size_t top_k){
+    ifstream file(path);
+    if(!file)
+        return false;
+
+    string file_header;
+    getline(file, file_header);
+    if(file_header != header)
+        throw runtime_error("checkpoint " + path + " was made with different parameters");
+
+    if(!(file >> next_pattern >> scored))
+        throw runtime_error("corrupted checkpoint " + path);
+
+    enumeration_entry_t entry;
+    while(file >> entry.score >> entry.steps >> entry.pattern)
+        push_top_k(top, top_k, entry);
+
+    return true;
+}
+
+vector<enumeration_entry_t> enumerate_starting_boards(const ga_params_t& params, size_t top_k, size_t prune_steps, uint64_t chunk_size,
+                                                      ThreadPool& pool, size_t max_chunks_in_flight, const string& checkpoint_path, ostream& os){
+    const size_t num_cells = params.startingboard_sizeX * params.startingboard_sizeY;
+    if(num_cells < 1 || num_cells > MAX_ENUMERATION_CELLS)
+        throw runtime_error("can't enumerate starting boards of " + to_string(num_cells) + " cells, the maximum is " + to_string(MAX_ENUMERATION_CELLS));
+    if(params.startingboard_sizeX > params.gameboard_sizeX || params.startingboard_sizeY > params.gameboard_sizeY)
+        throw runtime_error("size of the starting board too big");
+    if(chunk_size < 1 || max_chunks_in_flight < 1)
+        throw runtime_error("chunk size and chunks in flight must be at least 1");
+    if(params.startingboard_sizeX + 2 * prune_steps + 2 > 64)
+        throw runtime_error("too many pruning steps for a starting board this wide");
+
+    //Pruning is only exact if the cells can't reach the walls of the game board in prune_steps steps
+    {
+        const size_t offsetX = (params.gameboard_sizeX - params.startingboard_sizeX) / 2;
+        const size_t offsetY = (params.gameboard_sizeY - params.startingboard_sizeY) / 2;
+        const size_t margin = min(min(offsetX, params.gameboard_sizeX - params.startingboard_sizeX - offsetX),
+                                  min(offsetY, params.gameboard_sizeY - params.startingboard_sizeY - offsetY));
+        if(params.wrap_edges || prune_steps > margin)
+            prune_steps = (params.wrap_edges ? 0 : margin);
+    }
+
+    const uint64_t total_patterns = 1ULL << num_cells;
+    const string header = checkpoint_header(params, top_k, prune_steps);
+    uint64_t next_pattern = 0;
+    uint64_t scored = 0;
+    vector<enumeration_entry_t> top;
+
+    if(!checkpoint_path.empty() && load_checkpoint(checkpoint_path, header, next_pattern, scored, top, top_k))
+        os << "Resuming from checkpoint " << checkpoint_path << " at pattern " << next_pattern << "/" << total_patterns << endl;
+
+    //Chunks are collected in the same order they've been enqueued, so that everything before next_pattern is always done
+    deque<future<enumeration_chunk_t>> chunks_in_flight;
+    uint64_t next_pattern_to_enqueue = next_pattern;
+    auto last_checkpoint_time = chrono::steady_clock::now();
+
+    while(next_pattern_to_enqueue < total_patterns || !chunks_in_flight.empty()){
+        while(next_pattern_to_enqueue < total_patterns && chunks_in_flight.size() < max_chunks_in_flight){
+            const uint64_t begin = next_pattern_to_enqueue;
+            const uint64_t end = (total_patterns - begin > chunk_size ? begin + chunk_size : total_patterns);
+            chunks_in_flight.emplace_back(pool.enqueue([params, begin, end, top_k, prune_steps](){
+                return enumerate_chunk(params, begin, end, top_k, prune_steps);
+            }));
+            next_pattern_to_enqueue = end;
+        }
+
+        enumeration_chunk_t chunk = chunks_in_flight.front().get();
+        chunks_in_flight.pop_front();
+
+        for(const auto& entry : chunk.top)
+            push_top_k(top, top_k, entry);
+        scored += chunk.scored;
+        next_pattern = chunk.end;
+
+        const auto now = chrono::steady_clock::now();
+        if(now - last_checkpoint_time >= chrono::seconds(CHECKPOINT_INTERVAL_SECONDS) || next_pattern == total_patterns){
+            if(!checkpoint_path.empty())
+                save_checkpoint(checkpoint_path, header, next_pattern, scored, top);
+            last_checkpoint_time = now;
+
+            os << "Enumerated " << next_pattern << "/" << total_patterns << " patterns, " << scored << " of them scored";
+            if(!top.empty()) os << ", best score so far: " << min_element(top.begin(), top.end(), is_better)->score;
+            os << endl;
+        }
+    }
+
+    sort(top.begin(), top.end(), is_better);
+    return top;
+}
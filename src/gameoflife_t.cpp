@@ -2,24 +2,59 @@
 
 #include <iostream>
 #include <stdexcept>
+#include <cctype>
 #include <ctime>
 #include <vector>
 #include <string>
 
 using namespace std;
 
-gameoflife_t::gameoflife_t(size_t _sizeX, size_t _sizeY, bool _wrap_edges) {
+gameoflife_t::gameoflife_t(size_t _sizeX, size_t _sizeY, bool _wrap_edges, uint32_t _rule) {
     if(_sizeX < 1 || _sizeY < 1)
         throw runtime_error("size of the board too small");
+    if(_rule >= (1u << (2 * RULE_SURVIVAL_SHIFT)))
+        throw runtime_error("invalid rule");
 
     board = vector<vector<bool>>(_sizeY, vector<bool>(_sizeX, false));
     sizeX = _sizeX;
     sizeY = _sizeY;
     wrap_edges = _wrap_edges;
+    rule = _rule;
 
     live_cells = 0;
 }
 
+//Parse a rule in B/S notation, e.g. "B3/S23" for Conway's Game of Life or "B36/S23" for HighLife
+uint32_t gameoflife_t::parse_rule(const string& rule_string){
+    size_t slash_pos = rule_string.find('/');
+    if(rule_string.empty() || toupper(rule_string[0]) != 'B' ||
+       slash_pos == string::npos || slash_pos + 1 >= rule_string.size() || toupper(rule_string[slash_pos + 1]) != 'S')
+        throw runtime_error("invalid rule \"" + rule_string + "\", expected something like B3/S23");
+
+    uint32_t rule_mask = 0;
+    for(size_t i = 1; i < rule_string.size(); ++i){
+        if(i == slash_pos || i == slash_pos + 1)
+            continue;
+        if(rule_string[i] < '0' || rule_string[i] > '8')
+            throw runtime_error("invalid rule \"" + rule_string + "\", expected something like B3/S23");
+
+        rule_mask |= 1u << ((i > slash_pos ? RULE_SURVIVAL_SHIFT : 0) + (rule_string[i] - '0'));
+    }
+
+    return rule_mask;
+}
+
+//Inverse of parse_rule
+string gameoflife_t::rule_to_string(uint32_t rule_mask){
+    string rule_string = "B";
+    for(int n = 0; n <= 8; ++n)
+        if((rule_mask >> n) & 1) rule_string += static_cast<char>('0' + n);
+    rule_string += "/S";
+    for(int n = 0; n <= 8; ++n)
+        if((rule_mask >> (RULE_SURVIVAL_SHIFT + n)) & 1) rule_string += static_cast<char>('0' + n);
+    return rule_string;
+}
+
 int gameoflife_t::set_cell(size_t posX, size_t posY, bool state){
     if(posX >= sizeX || posY >= sizeY)
         throw runtime_error("setting non-existent board cell at (" + to_string(posX) + ", " + to_string(posY) + ")");
@@ -116,21 +151,14 @@ int gameoflife_t::step_simulation(unsigned int num_steps){
         for(size_t i = 0; i < sizeY; ++i){
             for(size_t j = 0; j < sizeX; ++j){
                 int num_neighbours = count_neighbours(j, i);
-
-                if(num_neighbours < 2 || num_neighbours > 3){
-                    //Set new board to updated value
-                    new_board[i][j] = false;
-                    //If in the old board the cell was alive, decrease the live cells counter
-                    if(board[i][j] == true)
-                        --live_cells;
-                }
-                if(num_neighbours == 3){
-                    //Set new board to updated value
-                    new_board[i][j] = true;
-                    //If in the old board the cell was dead, increase the live cells counter
-                    if(board[i][j] == false)
-                        ++live_cells;
-                }
+                bool alive = board[i][j];
+
+                //Look up the new state in the rule, without branching on the number of neighbours
+                bool new_state = (rule >> (alive * RULE_SURVIVAL_SHIFT + num_neighbours)) & 1;
+                new_board[i][j] = new_state;
+                //Update the live cells counter
+                live_cells += new_state;
+                live_cells -= alive;
             }
         }
         board = new_board;
@@ -0,0 +1,113 @@
+#include "genetic_algorithm.h"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <future>
+#include <random>
+
+using namespace std;
+
+//Simulate every player of the population on the shared thread pool
+void evaluate_population_on_pool(vector<player>& population, const ga_params_t& params, ThreadPool& pool){
+    vector<future<size_t>> dummy_stepscompleted;
+    for(player& p : population){
+        dummy_stepscompleted.emplace_back(
+            pool.enqueue([&](){
+                p.init_simulation((params.gameboard_sizeX - params.startingboard_sizeX) / 2, (params.gameboard_sizeY - params.startingboard_sizeY) / 2,
+                                  params.cost_per_starting_cell, params.reward_per_step_completed, params.reward_per_alive_cell_per_step);
+                return p.step_simulation_until_periodic();
+            })
+        );
+    }
+
+    //Block current thread until all players have been simulated
+    for(auto&& dummy : dummy_stepscompleted) dummy.get();
+}
+
+//Encode a starting board row by row, so that it fits in a single field of a results table
+string encode_starting_board(const vector<vector<bool>>& board){
+    string encoded;
+    for(size_t i = 0; i < board.size(); ++i){
+        if(i != 0) encoded += '/';
+        for(bool cell : board[i])
+            encoded += (cell ? 'o' : '.');
+    }
+    return encoded;
+}
+
+//Run the whole genetic algorithm: evaluate, sort, report and mutate the population for params.gen_to_sim generations
+ga_result_t run_genetic_algorithm(const ga_params_t& params, const population_evaluator_t& evaluate_population, ostream* log){
+    vector<player> population(params.population_size, player(params.gameboard_sizeX, params.gameboard_sizeY, params.startingboard_sizeX, params.startingboard_sizeY, params.wrap_edges, params.rule));
+    ga_result_t result;
+    result.best_score = 0;
+
+    //Every run has its own generator, runs of a sweep are driven by different threads at the same time
+    mt19937 rng(params.seed);
+
+    //Skip the worst 90% of the players
+    size_t worst_best_player_index = (9 * population.size()) / 10;
+
+    double best_players_curr_gen_avg_score = 0;
+    double best_players_prev_gen_avg_score = 0;
+    double all_players_curr_gen_avg_score = 0;
+    double all_players_prev_gen_avg_score = 0;
+
+    for(player &p : population)
+        p.random_fill_starting_board(rng, params.randomfill_percentage);
+
+    for(int generation = 0; generation < params.gen_to_sim; ++generation) {
+        if(log){
+            *log << "------------------------------------------------------------------------------------------------" << endl;
+            *log << "Simulationg now generation " << generation << "/" << params.gen_to_sim << endl;
+        }
+        best_players_curr_gen_avg_score = 0;
+        all_players_curr_gen_avg_score = 0;
+
+        evaluate_population(population);
+
+        for(player& p : population) {
+            all_players_curr_gen_avg_score += p.score;
+        }
+        all_players_curr_gen_avg_score /= (double)population.size();
+
+        sort(population.begin(), population.end(), [](const player & p1, const player & p2) {return p1.score < p2.score;});
+
+        for(auto i = worst_best_player_index; i < population.size(); ++i) {
+            auto& p = population[i];
+            if(log){
+                *log << "(" << i << ") Score of the following board: " << p.score << endl;
+                p.print_starting_board(*log);
+            }
+            best_players_curr_gen_avg_score += p.score;
+        }
+        best_players_curr_gen_avg_score /= (double)(population.size() - worst_best_player_index);
+        //
+        if(log){
+            *log << "Current generation average  score: " << all_players_curr_gen_avg_score  << " (prev.: " << all_players_prev_gen_avg_score  << ")" << endl;
+            *log << "Current generation best avg score: " << best_players_curr_gen_avg_score << " (prev.: " << best_players_prev_gen_avg_score << ")" << endl;
+        }
+        //
+        //Keep track of the convergence curve and of the best board found so far
+        result.curve.push_back({generation, all_players_curr_gen_avg_score, best_players_curr_gen_avg_score, population.back().score});
+        if(generation == 0 || population.back().score > result.best_score){
+            result.best_score = population.back().score;
+            result.best_starting_board = population.back().get_starting_board();
+        }
+        //
+        for(size_t i = 0; i < worst_best_player_index; ++i) {
+            auto& p = population[i];
+            //This formula picks the best player in a round robin way with each cycle of this for loop (offset + (i % num_best_players))
+            auto& ref_p = population[worst_best_player_index + (i % (population.size() - worst_best_player_index))];
+
+            p.mutate(rng, ref_p.get_starting_board(), params.prob_cell_change_state, params.prob_cell_relocate, params.prob_big_mutations, params.prob_complete_mutation, params.randomfill_percentage);
+        }
+        //
+        //
+        all_players_prev_gen_avg_score = all_players_curr_gen_avg_score;
+        best_players_prev_gen_avg_score = best_players_curr_gen_avg_score;
+    }
+
+    return result;
+}
@@ -5,12 +5,19 @@
 #include <vector>
 #include <array>
 #include <string>
+#include <random>
+#include <algorithm>
 
 using namespace std;
 
+//Random percentage in [0, 100]
+static float random_percentage(mt19937& rng){
+    return uniform_real_distribution<float>(0.0f, 100.0f)(rng);
+}
+
 //Constructor
-player::player(size_t _game_board_sizeX, size_t _game_board_sizeY, size_t _starting_board_sizeX, size_t _starting_board_sizeY, bool _wrap_edges) {
-    game = gameoflife_t(_game_board_sizeX, _game_board_sizeY, _wrap_edges);
+player::player(size_t _game_board_sizeX, size_t _game_board_sizeY, size_t _starting_board_sizeX, size_t _starting_board_sizeY, bool _wrap_edges, uint32_t _rule) {
+    game = gameoflife_t(_game_board_sizeX, _game_board_sizeY, _wrap_edges, _rule);
 
     if(_starting_board_sizeX < 1 || _starting_board_sizeY < 1)
         throw runtime_error("size of the starting board too small");
@@ -32,10 +39,10 @@ int player::set_starting_board_cell(size_t posX, size_t posY, bool state){
 }
 
 //Randomly fill starting board
-void player::random_fill_starting_board(float percentage){
+void player::random_fill_starting_board(mt19937& rng, float percentage){
     for(size_t i = 0; i < starting_board_sizeY; ++i){
         for(size_t j = 0; j < starting_board_sizeX; ++j){
-            if(static_cast<float>(rand()) / (static_cast<float>(RAND_MAX/100)) <= percentage){
+            if(random_percentage(rng) <= percentage){
                 set_starting_board_cell(j, i, 1);
             }
         }
@@ -83,6 +90,7 @@ int player::init_simulation(size_t x_offset, size_t y_offset, double _cost_per_s
 
     //Reset variables
     score = 0;
+    steps_completed = 0;
     cost_per_starting_cell = _cost_per_starting_cell;
     reward_per_step_completed = _reward_per_step_completed;
     reward_per_alive_cell_every_step = _reward_per_alive_cell_every_step;
@@ -107,6 +115,7 @@ int player::init_simulation(size_t x_offset, size_t y_offset, double _cost_per_s
 //Function to single-step the simulation of the Game of Life
 int player::step_simulation(size_t num_steps){
     game.step_simulation(num_steps);
+    steps_completed += num_steps;
 
     score += reward_per_step_completed;
     score += game.get_live_cells_count() * reward_per_alive_cell_every_step;
@@ -116,12 +125,36 @@ int player::step_simulation(size_t num_steps){
     return 0;
 }
 
-//Function to step the simulation of the Game of Life until periodicity is detected
-size_t player::step_simulation_until_periodic(){
+//Function to step the simulation of the Game of Life until periodicity is detected.
+//If extent isn't null, it's filled with the extent of the live cells of every board stepped through, starting board included
+size_t player::step_simulation_until_periodic(live_extent_t* extent){
     size_t steps_counter = 0;
 
+    auto update_extent = [&](){
+        const auto& gameboard = game.get_board();
+        for(size_t i = 0; i < game.get_sizeY(); ++i){
+            for(size_t j = 0; j < game.get_sizeX(); ++j){
+                if(!gameboard[i][j])
+                    continue;
+                if(!extent->any_alive){
+                    *extent = {true, j, i, j, i};
+                } else {
+                    extent->minX = min(extent->minX, j); extent->maxX = max(extent->maxX, j);
+                    extent->minY = min(extent->minY, i); extent->maxY = max(extent->maxY, i);
+                }
+            }
+        }
+    };
+
+    if(extent){
+        extent->any_alive = false;
+        update_extent();
+    }
+
     while(!detect_periodicity(board_history)){
         step_simulation();
+        if(extent)
+            update_extent();
 
         if(board_history.size() > MAX_HISTORY_SIZE)
             board_history.erase(board_history.begin());
@@ -197,19 +230,19 @@ int player::detect_periodicity(const vector<vector<vector<bool>>>& boards){
 }
 
 //Function to mutate the current player' starting board, based on another player' starting board
-int player::mutate( const decltype(starting_board)& ref_starting_board,
+int player::mutate( mt19937& rng, const decltype(starting_board)& ref_starting_board,
                     float probability_cell_change_state,   float probability_cell_relocate,
                     const float probability_big_mutations, const float probability_complete_mutation, const float random_fill_percentage){
 
     //Check for big or complete mutations
     //complete mutation
-    if(static_cast<float>(rand()) / (static_cast<float>(RAND_MAX/100)) <= probability_complete_mutation){
-        random_fill_starting_board(random_fill_percentage);
+    if(random_percentage(rng) <= probability_complete_mutation){
+        random_fill_starting_board(rng, random_fill_percentage);
         return 2;
     }
     //big mutations
     bool big_mutations = false;
-    if(static_cast<float>(rand()) / (static_cast<float>(RAND_MAX/100)) <= probability_big_mutations){
+    if(random_percentage(rng) <= probability_big_mutations){
         probability_cell_change_state *= 5;
         probability_cell_relocate *= 5;
 
@@ -228,19 +261,19 @@ int player::mutate( const decltype(starting_board)& ref_starting_board,
         for(size_t i = 0; i < starting_board_sizeY; ++i){
             for(size_t j = 0; j < starting_board_sizeX; ++j){
                 //Check if cell will change state
-                if(static_cast<float>(rand()) / (static_cast<float>(RAND_MAX/100)) <= probability_cell_change_state){
+                if(random_percentage(rng) <= probability_cell_change_state){
                     starting_board[i][j] = !ref_starting_board[i][j];
                     mutations_happened = true;
                 } else
 
                 //Check if cell is alive and it will be relocated
-                if(ref_starting_board[i][j] == true && static_cast<float>(rand()) / (static_cast<float>(RAND_MAX/100)) <= probability_cell_relocate){
+                if(ref_starting_board[i][j] == true && random_percentage(rng) <= probability_cell_relocate){
                     size_t new_random_posX = 0;
                     size_t new_random_posY = 0;
                     int attempts = 0;
                     do{
-                        new_random_posX = rand() % starting_board_sizeX;
-                        new_random_posY = rand() % starting_board_sizeY;
+                        new_random_posX = uniform_int_distribution<size_t>(0, starting_board_sizeX - 1)(rng);
+                        new_random_posY = uniform_int_distribution<size_t>(0, starting_board_sizeY - 1)(rng);
                         ++attempts;
                     }while(ref_starting_board[new_random_posY][new_random_posX] == true && attempts < 20);
 
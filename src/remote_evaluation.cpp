@@ -0,0 +1,503 @@
+#include "remote_evaluation.h"
+
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <deque>
+#include <string>
+#include <cstring>
+#include <cerrno>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <atomic>
+#include <utility>
+#include <ThreadPool.h>
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+
+using namespace std;
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+//Serialization
+
+static void put_u8(string& buf, uint8_t value){
+    buf.push_back(static_cast<char>(value));
+}
+
+static void put_u32(string& buf, uint32_t value){
+    for(int i = 0; i < 4; ++i)
+        buf.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+}
+
+static void put_u64(string& buf, uint64_t value){
+    for(int i = 0; i < 8; ++i)
+        buf.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+}
+
+static void put_f64(string& buf, double value){
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    put_u64(buf, bits);
+}
+
+static uint32_t get_u32(const unsigned char* buf){
+    uint32_t value = 0;
+    for(int i = 0; i < 4; ++i)
+        value |= static_cast<uint32_t>(buf[i]) << (8 * i);
+    return value;
+}
+
+static uint64_t get_u64(const unsigned char* buf){
+    uint64_t value = 0;
+    for(int i = 0; i < 8; ++i)
+        value |= static_cast<uint64_t>(buf[i]) << (8 * i);
+    return value;
+}
+
+static double get_f64(const unsigned char* buf){
+    uint64_t bits = get_u64(buf);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+//Send the whole buffer, false if the connection broke
+static bool send_all(int fd, const string& buf){
+    size_t sent = 0;
+    while(sent < buf.size()){
+        ssize_t n = send(fd, buf.data() + sent, buf.size() - sent, MSG_NOSIGNAL);
+        if(n <= 0)
+            return false;
+        sent += n;
+    }
+    return true;
+}
+
+//Receive exactly size bytes, false if the connection broke, was closed or timed out
+static bool recv_all(int fd, unsigned char* buf, size_t size){
+    size_t received = 0;
+    while(received < size){
+        ssize_t n = recv(fd, buf + received, size - received, 0);
+        if(n <= 0)
+            return false;
+        received += n;
+    }
+    return true;
+}
+
+static size_t packed_board_size(size_t sizeX, size_t sizeY){
+    return (sizeX * sizeY + 7) / 8;
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+//Worker
+
+//Batch received by a worker, whose boards are being simulated on the thread pool
+struct pending_batch_t
+{
+    uint32_t batch_id;
+    vector<future<pair<double, size_t>>> results;
+};
+
+//Serve a single master: the reader (this thread) hands the boards of every batch to the pool as soon as they're received, while the writer
+//sends back the results in order, each one as soon as it's ready. This way the pool already has the next batches queued while the results
+//of the previous ones are sent, and the master sees progress on every board instead of on every batch
+static void serve_connection(int fd, ThreadPool& pool){
+    deque<pending_batch_t> pending_batches;
+    bool reader_done = false;
+    //Set when the connection is gone, so that the boards still queued on the pool are dropped instead of simulated for nobody
+    auto connection_closed = make_shared<atomic<bool>>(false);
+    mutex pending_mutex;
+    condition_variable pending_condition;
+
+    thread writer([&](){
+        for(;;){
+            pending_batch_t batch;
+            {
+                unique_lock<mutex> lock(pending_mutex);
+                pending_condition.wait(lock, [&]{return reader_done || !pending_batches.empty();});
+                if(pending_batches.empty())
+                    return;
+                batch = move(pending_batches.front());
+                pending_batches.pop_front();
+            }
+
+            if(*connection_closed){
+                //Wait for the boards that were already being simulated, the others return right away
+                for(auto& result : batch.results)
+                    result.wait();
+                continue;
+            }
+
+            string header;
+            put_u32(header, RESPONSE_MAGIC);
+            put_u32(header, batch.batch_id);
+            put_u32(header, batch.results.size());
+            bool sent = send_all(fd, header);
+
+            for(auto& result : batch.results){
+                string record;
+                try{
+                    auto score_and_steps = result.get();
+                    put_f64(record, score_and_steps.first);
+                    put_u64(record, score_and_steps.second);
+                } catch(const exception&){
+                    //The master will retry the batch somewhere else
+                    sent = false;
+                }
+                sent = sent && !*connection_closed && send_all(fd, record);
+
+                //If the master went away, shut the connection down so that the reader stops and drops the rest of the work
+                if(!sent){
+                    *connection_closed = true;
+                    shutdown(fd, SHUT_RDWR);
+                }
+            }
+        }
+    });
+
+    for(;;){
+        unsigned char header[REQUEST_HEADER_SIZE];
+        if(!recv_all(fd, header, REQUEST_HEADER_SIZE))
+            break;
+
+        const uint32_t magic = get_u32(header);
+        const uint32_t batch_id = get_u32(header + 4);
+        const uint32_t num_boards = get_u32(header + 8);
+        ga_params_t params = {};
+        params.gameboard_sizeX = get_u32(header + 12);
+        params.gameboard_sizeY = get_u32(header + 16);
+        params.startingboard_sizeX = get_u32(header + 20);
+        params.startingboard_sizeY = get_u32(header + 24);
+        params.wrap_edges = header[28];
+        params.cost_per_starting_cell = get_f64(header + 29);
+        params.reward_per_step_completed = get_f64(header + 37);
+        params.reward_per_alive_cell_per_step = get_f64(header + 45);
+        params.rule = get_u32(header + 53);
+
+        //Refuse garbage instead of trying to allocate it
+        if(magic != REQUEST_MAGIC || num_boards > MAX_BOARDS_PER_BATCH || params.rule >= (1u << (2 * RULE_SURVIVAL_SHIFT)) ||
+           params.gameboard_sizeX > MAX_BOARD_SIZE || params.gameboard_sizeY > MAX_BOARD_SIZE ||
+           static_cast<uint64_t>(params.gameboard_sizeX) * params.gameboard_sizeY > MAX_BOARD_CELLS ||
+           params.startingboard_sizeX < 1 || params.startingboard_sizeY < 1 ||
+           params.startingboard_sizeX > params.gameboard_sizeX || params.startingboard_sizeY > params.gameboard_sizeY)
+            break;
+
+        const size_t board_bytes = packed_board_size(params.startingboard_sizeX, params.startingboard_sizeY);
+        if(num_boards * board_bytes > MAX_BATCH_BYTES)
+            break;
+        vector<unsigned char> boards(num_boards * board_bytes);
+        if(!recv_all(fd, boards.data(), boards.size()))
+            break;
+
+        pending_batch_t batch;
+        batch.batch_id = batch_id;
+        for(size_t b = 0; b < num_boards; ++b){
+            vector<unsigned char> packed_board(boards.begin() + b * board_bytes, boards.begin() + (b + 1) * board_bytes);
+            batch.results.emplace_back(
+                pool.enqueue([params, packed_board, connection_closed](){
+                    if(*connection_closed)
+                        return make_pair(0.0, size_t(0));
+
+                    player p(params.gameboard_sizeX, params.gameboard_sizeY, params.startingboard_sizeX, params.startingboard_sizeY, params.wrap_edges, params.rule);
+                    for(size_t i = 0; i < params.startingboard_sizeY; ++i){
+                        for(size_t j = 0; j < params.startingboard_sizeX; ++j){
+                            const size_t bit = i * params.startingboard_sizeX + j;
+                            p.set_starting_board_cell(j, i, (packed_board[bit / 8] >> (bit % 8)) & 1);
+                        }
+                    }
+
+                    p.init_simulation((params.gameboard_sizeX - params.startingboard_sizeX) / 2, (params.gameboard_sizeY - params.startingboard_sizeY) / 2,
+                                      params.cost_per_starting_cell, params.reward_per_step_completed, params.reward_per_alive_cell_per_step);
+                    size_t steps = p.step_simulation_until_periodic();
+                    return make_pair(p.score, steps);
+                })
+            );
+        }
+
+        {
+            lock_guard<mutex> lock(pending_mutex);
+            pending_batches.push_back(move(batch));
+        }
+        pending_condition.notify_one();
+    }
+
+    {
+        lock_guard<mutex> lock(pending_mutex);
+        reader_done = true;
+        *connection_closed = true;
+    }
+    pending_condition.notify_one();
+    writer.join();
+
+    //Let the master know right away, the socket itself is closed by run_worker
+    shutdown(fd, SHUT_RDWR);
+}
+
+int run_worker(const string& socket_path, size_t num_threads, ostream& os){
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if(socket_path.size() >= sizeof(address.sun_path))
+        throw runtime_error("socket path too long: " + socket_path);
+    strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(listen_fd < 0)
+        throw runtime_error("can't create socket");
+
+    //Remove the socket left behind by a previous worker
+    unlink(socket_path.c_str());
+    if(bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listen_fd, 16) != 0){
+        close(listen_fd);
+        throw runtime_error("can't listen on " + socket_path + ": " + strerror(errno));
+    }
+
+    ThreadPool pool(num_threads);
+    os << "Worker listening on " << socket_path << " with " << num_threads << " threads" << endl;
+
+    //Every master gets its own connection thread, all of them share the same pool. The threads are kept track of so that none of them
+    //is left using the pool once it's destroyed; the socket is closed here, only after its thread is done with it
+    struct connection_t
+    {
+        int fd;
+        thread serving;
+        shared_ptr<atomic<bool>> finished;
+    };
+    vector<connection_t> connections;
+
+    for(;;){
+        int fd = accept(listen_fd, nullptr, nullptr);
+        if(fd < 0){
+            if(errno == EINTR)
+                continue;
+            const string error = strerror(errno);
+
+            //Stop every connection before the pool goes away
+            for(auto& c : connections)
+                shutdown(c.fd, SHUT_RDWR);
+            for(auto& c : connections){
+                c.serving.join();
+                close(c.fd);
+            }
+            close(listen_fd);
+            throw runtime_error("accept failed: " + error);
+        }
+
+        //Forget the connections that are over
+        for(size_t i = 0; i < connections.size(); ){
+            if(*connections[i].finished){
+                connections[i].serving.join();
+                close(connections[i].fd);
+                connections[i] = move(connections.back());
+                connections.pop_back();
+            } else {
+                ++i;
+            }
+        }
+
+        auto finished = make_shared<atomic<bool>>(false);
+        connections.push_back({fd, thread([fd, &pool, finished](){
+            serve_connection(fd, pool);
+            *finished = true;
+        }), finished});
+    }
+
+    return 0;
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+//Master
+
+remote_evaluator_t::remote_evaluator_t(const vector<string>& socket_paths, size_t _batch_size, size_t _max_batches_in_flight, unsigned int _timeout_seconds, ostream* _log) {
+    if(socket_paths.empty())
+        throw runtime_error("at least one worker is required");
+    if(_batch_size < 1 || _batch_size > MAX_BOARDS_PER_BATCH)
+        throw runtime_error("invalid batch size");
+    if(_max_batches_in_flight < 1)
+        throw runtime_error("at least one batch in flight is required");
+
+    for(const string& path : socket_paths)
+        workers.push_back({path, -1});
+    batch_size = _batch_size;
+    max_batches_in_flight = _max_batches_in_flight;
+    timeout_seconds = _timeout_seconds;
+    log = _log;
+}
+
+bool remote_evaluator_t::connect_worker(worker_t& w){
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if(w.socket_path.size() >= sizeof(address.sun_path))
+        return false;
+    strncpy(address.sun_path, w.socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd < 0)
+        return false;
+    if(connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0){
+        close(fd);
+        return false;
+    }
+
+    //A worker that stops answering is treated like one that closed the connection
+    timeval timeout;
+    timeout.tv_sec = timeout_seconds;
+    timeout.tv_usec = 0;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    w.fd = fd;
+    return true;
+}
+
+void remote_evaluator_t::disconnect_worker(worker_t& w){
+    if(w.fd >= 0)
+        close(w.fd);
+    w.fd = -1;
+}
+
+void remote_evaluator_t::evaluate(vector<player>& population, const ga_params_t& params){
+    //Workers refuse these, don't mistake that for all of them dying
+    if(params.gameboard_sizeX > MAX_BOARD_SIZE || params.gameboard_sizeY > MAX_BOARD_SIZE ||
+       static_cast<uint64_t>(params.gameboard_sizeX) * params.gameboard_sizeY > MAX_BOARD_CELLS)
+        throw runtime_error("game board too big to be evaluated by the workers");
+
+    //(Re)connect every worker that isn't connected
+    for(worker_t& w : workers){
+        if(w.fd < 0 && !connect_worker(w) && log)
+            *log << "Can't connect to worker " << w.socket_path << endl;
+    }
+
+    //Batches are identified by their index, batch b contains the players [b * batch_size, (b + 1) * batch_size)
+    const size_t num_batches = (population.size() + batch_size - 1) / batch_size;
+    deque<size_t> batches_to_send;
+    for(size_t b = 0; b < num_batches; ++b)
+        batches_to_send.push_back(b);
+    size_t completed_batches = 0;
+    mutex batches_mutex;
+    condition_variable batches_condition;
+
+    //Every worker has its own thread, which keeps up to max_batches_in_flight batches sent to it. If the worker fails,
+    //its batches go back to batches_to_send and the threads of the other workers pick them up
+    auto drive_worker = [&](worker_t& w){
+        deque<size_t> in_flight;
+
+        auto fail = [&](){
+            disconnect_worker(w);
+            {
+                lock_guard<mutex> lock(batches_mutex);
+                if(log) *log << "Worker " << w.socket_path << " failed, its batches will be retried on the other workers" << endl;
+                batches_to_send.insert(batches_to_send.end(), in_flight.begin(), in_flight.end());
+            }
+            batches_condition.notify_all();
+        };
+
+        for(;;){
+            //Take as many batches as allowed, or wait if there's nothing to do right now
+            deque<size_t> new_batches;
+            {
+                unique_lock<mutex> lock(batches_mutex);
+                if(in_flight.empty())
+                    batches_condition.wait(lock, [&]{return !batches_to_send.empty() || completed_batches == num_batches;});
+                if(in_flight.empty() && batches_to_send.empty())
+                    return;
+
+                while(in_flight.size() + new_batches.size() < max_batches_in_flight && !batches_to_send.empty()){
+                    new_batches.push_back(batches_to_send.front());
+                    batches_to_send.pop_front();
+                }
+            }
+
+            in_flight.insert(in_flight.end(), new_batches.begin(), new_batches.end());
+            for(size_t b : new_batches){
+                const size_t begin = b * batch_size;
+                const size_t end = min(begin + batch_size, population.size());
+                const size_t board_bytes = packed_board_size(params.startingboard_sizeX, params.startingboard_sizeY);
+
+                string request;
+                put_u32(request, REQUEST_MAGIC);
+                put_u32(request, b);
+                put_u32(request, end - begin);
+                put_u32(request, params.gameboard_sizeX);
+                put_u32(request, params.gameboard_sizeY);
+                put_u32(request, params.startingboard_sizeX);
+                put_u32(request, params.startingboard_sizeY);
+                put_u8(request, params.wrap_edges);
+                put_f64(request, params.cost_per_starting_cell);
+                put_f64(request, params.reward_per_step_completed);
+                put_f64(request, params.reward_per_alive_cell_per_step);
+                put_u32(request, params.rule);
+
+                for(size_t i = begin; i < end; ++i){
+                    string packed_board(board_bytes, '\0');
+                    const auto& starting_board = population[i].get_starting_board();
+                    for(size_t y = 0; y < params.startingboard_sizeY; ++y){
+                        for(size_t x = 0; x < params.startingboard_sizeX; ++x){
+                            const size_t bit = y * params.startingboard_sizeX + x;
+                            if(starting_board[y][x])
+                                packed_board[bit / 8] |= static_cast<char>(1 << (bit % 8));
+                        }
+                    }
+                    request += packed_board;
+                }
+
+                if(!send_all(w.fd, request)){
+                    fail();
+                    return;
+                }
+            }
+
+            //Results come back in the same order the batches were sent
+            const size_t b = in_flight.front();
+            const size_t begin = b * batch_size;
+            const size_t end = min(begin + batch_size, population.size());
+
+            unsigned char header[RESPONSE_HEADER_SIZE];
+            if(!recv_all(w.fd, header, RESPONSE_HEADER_SIZE) || get_u32(header) != RESPONSE_MAGIC || get_u32(header + 4) != b || get_u32(header + 8) != end - begin){
+                fail();
+                return;
+            }
+
+            vector<unsigned char> results((end - begin) * 16);
+            if(!recv_all(w.fd, results.data(), results.size())){
+                fail();
+                return;
+            }
+            for(size_t i = begin; i < end; ++i){
+                population[i].score = get_f64(results.data() + (i - begin) * 16);
+                population[i].steps_completed = get_u64(results.data() + (i - begin) * 16 + 8);
+            }
+
+            in_flight.pop_front();
+            {
+                lock_guard<mutex> lock(batches_mutex);
+                ++completed_batches;
+            }
+            batches_condition.notify_all();
+        }
+    };
+
+    vector<thread> drivers;
+    for(worker_t& w : workers){
+        if(w.fd >= 0)
+            drivers.emplace_back(drive_worker, ref(w));
+    }
+    for(thread& driver : drivers)
+        driver.join();
+
+    if(completed_batches != num_batches)
+        throw runtime_error("no workers left to evaluate the population");
+}
+
+remote_evaluator_t::~remote_evaluator_t() {
+    for(worker_t& w : workers)
+        disconnect_worker(w);
+}
@@ -0,0 +1,216 @@
+#include "sweep.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include <string>
+#include <set>
+#include <limits>
+#include <cctype>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <exception>
+
+using namespace std;
+
+//Parse a number, the whole string must be used
+static double parse_double(const string& value){
+    size_t parsed_chars = 0;
+    const double result = stod(value, &parsed_chars);
+    if(parsed_chars != value.size())
+        throw invalid_argument(value);
+    return result;
+}
+
+//Parse an unsigned int, the whole string must be used and its value must fit
+static unsigned int parse_unsigned(const string& value){
+    if(value.empty() || !isdigit(static_cast<unsigned char>(value[0])))
+        throw invalid_argument(value);
+    size_t parsed_chars = 0;
+    const unsigned long result = stoul(value, &parsed_chars);
+    if(parsed_chars != value.size())
+        throw invalid_argument(value);
+    if(result > numeric_limits<unsigned int>::max())
+        throw out_of_range(value);
+    return result;
+}
+
+//Set a single sweepable parameter by name, throws runtime_error if the name is unknown and logic_error if the value is invalid
+static void set_sweep_param(ga_params_t& params, const string& key, const string& value){
+    if     (key == "cost_per_starting_cell")            params.cost_per_starting_cell = parse_double(value);
+    else if(key == "reward_per_step_completed")         params.reward_per_step_completed = parse_double(value);
+    else if(key == "reward_per_alive_cell_per_step")    params.reward_per_alive_cell_per_step = parse_double(value);
+    else if(key == "prob_cell_change_state")            params.prob_cell_change_state = parse_double(value);
+    else if(key == "prob_cell_relocate")                params.prob_cell_relocate = parse_double(value);
+    else if(key == "prob_big_mutations")                params.prob_big_mutations = parse_double(value);
+    else if(key == "prob_complete_mutation")            params.prob_complete_mutation = parse_double(value);
+    else if(key == "seed")                              params.seed = parse_unsigned(value);
+    else
+        throw runtime_error("unknown sweep parameter \"" + key + "\"");
+}
+
+vector<ga_params_t> parse_sweep_file(const string& path, const ga_params_t& base_params){
+    ifstream file(path);
+    if(!file)
+        throw runtime_error("can't open sweep file " + path);
+
+    vector<ga_params_t> configs;
+    string line;
+    size_t line_number = 0;
+
+    while(getline(file, line)){
+        ++line_number;
+
+        //Strip comments
+        line = line.substr(0, line.find('#'));
+
+        //Every line starts as a single configuration equal to the base one, then each key multiplies it by the number of its values
+        vector<ga_params_t> line_configs(1, base_params);
+        bool empty_line = true;
+        bool seed_specified = false;
+        set<string> line_keys;
+
+        istringstream tokens(line);
+        string token;
+        while(tokens >> token){
+            empty_line = false;
+
+            size_t equal_pos = token.find('=');
+            if(equal_pos == string::npos || equal_pos == 0 || equal_pos == token.size() - 1)
+                throw runtime_error("malformed token \"" + token + "\" at line " + to_string(line_number) + " of " + path);
+
+            string key = token.substr(0, equal_pos);
+            if(!line_keys.insert(key).second)
+                throw runtime_error("parameter \"" + key + "\" given more than once at line " + to_string(line_number) + " of " + path);
+            if(key == "seed")
+                seed_specified = true;
+            vector<string> values;
+            {
+                istringstream values_stream(token.substr(equal_pos + 1));
+                string value;
+                while(getline(values_stream, value, ',')){
+                    //Check the value right away, so that errors point to the line
+                    try{
+                        ga_params_t check_params = base_params;
+                        set_sweep_param(check_params, key, value);
+                    } catch(const logic_error&){
+                        throw runtime_error("invalid value \"" + value + "\" at line " + to_string(line_number) + " of " + path);
+                    }
+                    values.push_back(value);
+                }
+            }
+
+            vector<ga_params_t> expanded_configs;
+            for(const auto& config : line_configs){
+                for(const string& value : values){
+                    ga_params_t new_config = config;
+                    set_sweep_param(new_config, key, value);
+                    expanded_configs.push_back(new_config);
+                }
+            }
+            line_configs = expanded_configs;
+        }
+
+        if(!empty_line){
+            //Unless a seed is given, every configuration gets a different one derived from the base seed
+            for(auto& config : line_configs){
+                if(!seed_specified)
+                    config.seed = base_params.seed + configs.size();
+                configs.push_back(config);
+            }
+        }
+    }
+
+    if(configs.empty())
+        throw runtime_error("no configurations found in sweep file " + path);
+
+    return configs;
+}
+
+//Write the columns that identify a configuration
+static void write_config_columns(ostream& os, size_t config_index, const ga_params_t& params){
+    os << config_index << ","
+       << params.cost_per_starting_cell << "," << params.reward_per_step_completed << "," << params.reward_per_alive_cell_per_step << ","
+       << params.prob_cell_change_state << "," << params.prob_cell_relocate << "," << params.prob_big_mutations << "," << params.prob_complete_mutation << ","
+       << params.seed << "," << gameoflife_t::rule_to_string(params.rule);
+}
+
+int run_sweep(const vector<ga_params_t>& configs, ThreadPool& pool, size_t max_concurrent_runs, const string& output_prefix, ostream& os){
+    if(max_concurrent_runs < 1)
+        throw runtime_error("at least one concurrent run is required");
+
+    //Both tables are opened before starting and every configuration is appended as soon as it completes, so that an interrupted sweep
+    //still has the results of the configurations that finished
+    ofstream curves_file(output_prefix + "_curves.csv");
+    if(!curves_file)
+        throw runtime_error("can't open " + output_prefix + "_curves.csv for writing");
+    ofstream best_file(output_prefix + "_best.csv");
+    if(!best_file)
+        throw runtime_error("can't open " + output_prefix + "_best.csv for writing");
+
+    //Convergence curves, one row per configuration per generation
+    curves_file << "config,cost_per_starting_cell,reward_per_step_completed,reward_per_alive_cell_per_step,"
+                << "prob_cell_change_state,prob_cell_relocate,prob_big_mutations,prob_complete_mutation,seed,rule,"
+                << "generation,all_players_avg_score,best_players_avg_score,best_score" << endl;
+    //Best board of every configuration
+    best_file << "config,cost_per_starting_cell,reward_per_step_completed,reward_per_alive_cell_per_step,"
+              << "prob_cell_change_state,prob_cell_relocate,prob_big_mutations,prob_complete_mutation,seed,rule,"
+              << "best_score,best_starting_board" << endl;
+
+    atomic<size_t> next_config(0);
+    size_t completed_configs = 0;
+    size_t failed_configs = 0;
+    mutex os_mutex;
+
+    //Each driver thread runs the serial part of one configuration at a time (sorting, mutating, bookkeeping) and only waits on the pool
+    //for the evaluation. While a driver is busy in its serial phase, the players enqueued by the other drivers keep the pool full
+    vector<thread> drivers;
+    for(size_t d = 0; d < min(max_concurrent_runs, configs.size()); ++d){
+        drivers.emplace_back([&](){
+            for(size_t c = next_config++; c < configs.size(); c = next_config++){
+                ga_result_t result;
+                string error;
+                try{
+                    const ga_params_t& params = configs[c];
+                    result = run_genetic_algorithm(params, [&](vector<player>& population){
+                        evaluate_population_on_pool(population, params, pool);
+                    });
+                } catch(const exception& e){
+                    error = e.what();
+                } catch(...){
+                    error = "unknown error";
+                }
+
+                lock_guard<mutex> lock(os_mutex);
+                ++completed_configs;
+                //Failed configurations are reported and left out of the tables
+                if(!error.empty()){
+                    ++failed_configs;
+                    os << "Configuration " << c << " failed (" << completed_configs << "/" << configs.size() << "): " << error << endl;
+                    continue;
+                }
+
+                for(const auto& stats : result.curve){
+                    write_config_columns(curves_file, c, configs[c]);
+                    curves_file << "," << stats.generation << "," << stats.all_players_avg_score << "," << stats.best_players_avg_score << "," << stats.best_score << "\n";
+                }
+                curves_file.flush();
+
+                write_config_columns(best_file, c, configs[c]);
+                best_file << "," << result.best_score << "," << encode_starting_board(result.best_starting_board) << endl;
+
+                os << "Configuration " << c << " completed (" << completed_configs << "/" << configs.size() << "), best score: " << result.best_score << endl;
+            }
+        });
+    }
+    for(thread& driver : drivers)
+        driver.join();
+
+    if(!curves_file || !best_file)
+        throw runtime_error("can't write the results to " + output_prefix + "_curves.csv and " + output_prefix + "_best.csv");
+
+    return failed_configs;
+}
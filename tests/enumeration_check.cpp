@@ -0,0 +1,82 @@
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <thread>
+
+#include <player.h>
+#include <gameoflife_t.h>
+#include <ThreadPool.h>
+#include <genetic_algorithm.h>
+#include <enumerator.h>
+
+#define TOP_K 10
+
+using namespace std;
+
+//Compare the enumeration against scoring every single starting board, for a starting board of sizeX * sizeY cells.
+//Returns the number of mismatches found
+int check_enumeration(size_t sizeX, size_t sizeY, ThreadPool& pool){
+    ga_params_t params = {};
+    params.gameboard_sizeX = 40;
+    params.gameboard_sizeY = 40;
+    params.startingboard_sizeX = sizeX;
+    params.startingboard_sizeY = sizeY;
+    params.wrap_edges = false;
+    params.rule = CONWAY_RULE;
+    params.cost_per_starting_cell = 3;
+    params.reward_per_step_completed = 1;
+    params.reward_per_alive_cell_per_step = 0.1;
+
+    //Brute force
+    vector<double> scores(1ULL << (sizeX * sizeY));
+    player p(params.gameboard_sizeX, params.gameboard_sizeY, sizeX, sizeY, params.wrap_edges, params.rule);
+    for(uint64_t pattern = 0; pattern < scores.size(); ++pattern){
+        for(size_t i = 0; i < sizeY; ++i)
+            for(size_t j = 0; j < sizeX; ++j)
+                p.set_starting_board_cell(j, i, (pattern >> (i * sizeX + j)) & 1);
+        p.init_simulation((params.gameboard_sizeX - sizeX) / 2, (params.gameboard_sizeY - sizeY) / 2,
+                          params.cost_per_starting_cell, params.reward_per_step_completed, params.reward_per_alive_cell_per_step);
+        p.step_simulation_until_periodic();
+        scores[pattern] = p.score;
+    }
+
+    //Enumeration, without pruning so that every board is comparable
+    ostringstream progress;
+    const auto top = enumerate_starting_boards(params, TOP_K, 0, 64, pool, 16, "", progress);
+
+    int mismatches = 0;
+    const string board_name = to_string(sizeX) + "x" + to_string(sizeY);
+
+    //Every reported board must have been scored at its own position
+    for(const auto& entry : top){
+        if(entry.score != scores[entry.pattern]){
+            cout << board_name << ": pattern " << entry.pattern << " reported with score " << entry.score << ", brute force gives " << scores[entry.pattern] << endl;
+            ++mismatches;
+        }
+    }
+
+    //Boards skipped by the enumeration share the score of a reported one, so every score at least as good as the worst reported one must be there
+    for(uint64_t pattern = 0; pattern < scores.size() && !top.empty(); ++pattern){
+        if(scores[pattern] < top.back().score)
+            continue;
+        if(none_of(top.begin(), top.end(), [&](const enumeration_entry_t& entry){return entry.score == scores[pattern];})){
+            cout << board_name << ": pattern " << pattern << " with score " << scores[pattern] << " is missing from the enumeration" << endl;
+            ++mismatches;
+        }
+    }
+
+    cout << board_name << ": best score " << (top.empty() ? 0 : top.front().score) << ", brute force " << *max_element(scores.begin(), scores.end())
+         << (mismatches == 0 ? ", OK" : ", FAILED") << endl;
+    return mismatches;
+}
+
+int main() {
+    ThreadPool pool(thread::hardware_concurrency() == 0 ? 4 : thread::hardware_concurrency());
+
+    int mismatches = 0;
+    mismatches += check_enumeration(3, 3, pool);
+    mismatches += check_enumeration(4, 3, pool);
+
+    return (mismatches == 0 ? 0 : 1);
+}
@@ -0,0 +1,26 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <stdexcept>
+
+#include <remote_evaluation.h>
+
+#define FALLBACK_NUM_THREADS 4
+
+using namespace std;
+
+//Standalone worker: ./gameoflife_worker <socket path> [number of threads]
+int main(int argc, char* argv[]) {
+    if(argc < 2){
+        cerr << "Usage: " << argv[0] << " <socket path> [number of threads]" << endl;
+        return 1;
+    }
+
+    try{
+        const unsigned int available_threads = (argc >= 3 ? stoul(argv[2]) : (thread::hardware_concurrency() == 0 ? FALLBACK_NUM_THREADS : thread::hardware_concurrency()));
+        return run_worker(argv[1], available_threads);
+    } catch(const exception& e){
+        cerr << "Worker failed: " << e.what() << endl;
+        return 1;
+    }
+}